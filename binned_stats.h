@@ -0,0 +1,93 @@
+#ifndef BINNED_STATS_H
+#define BINNED_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Streaming statistics for the plotters. Both accumulators are filled one entry at a
+// time while the input is read and can be merged, so per-plane, per-file or per-thread
+// copies add up to the same result. Memory does not depend on the number of entries.
+
+// Count, sum, min and max of one quantity
+struct RunningStats {
+    size_t n = 0;
+    double sum = 0.0;
+    float min = std::numeric_limits<float>::max();
+    float max = std::numeric_limits<float>::lowest();
+
+    void fill(float v) {
+        n++;
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+
+    void merge(const RunningStats& other) {
+        n += other.n;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    // 0 when empty, like the plot labels expect
+    double mean() const { return n > 0 ? sum / n : 0.0; }
+    float min_or_zero() const { return n > 0 ? min : 0.0f; }
+    float max_or_zero() const { return n > 0 ? max : 0.0f; }
+};
+
+// Count, sum and sum of squares of y in fixed-width bins of x over [xmin, xmax).
+// Entries outside the range are ignored.
+class BinnedStats {
+public:
+    BinnedStats(int nbins, double xmin, double xmax)
+        : nbins_(nbins), xmin_(xmin), xmax_(xmax), width_((xmax - xmin) / nbins),
+          n_(nbins, 0), sum_(nbins, 0.0), sum2_(nbins, 0.0) {}
+
+    void fill(double x, double y) {
+        // Range check before the cast: also rejects NaN, and inf or huge x would
+        // overflow the int conversion
+        if (!(x >= xmin_ && x < xmax_)) return;
+        int b = static_cast<int>((x - xmin_) / width_);
+        if (b >= nbins_) return; // x just below xmax can round up to nbins
+        n_[b]++;
+        sum_[b] += y;
+        sum2_[b] += y * y;
+    }
+
+    // Binning must match
+    void merge(const BinnedStats& other) {
+        for (int b = 0; b < nbins_; ++b) {
+            n_[b] += other.n_[b];
+            sum_[b] += other.sum_[b];
+            sum2_[b] += other.sum2_[b];
+        }
+    }
+
+    int nbins() const { return nbins_; }
+    double width() const { return width_; }
+    double center(int b) const { return xmin_ + (b + 0.5) * width_; }
+    size_t count(int b) const { return n_[b]; }
+    double mean(int b) const { return n_[b] > 0 ? sum_[b] / n_[b] : 0.0; }
+
+    // Standard error of the mean: population standard deviation / sqrt(n)
+    double mean_error(int b) const {
+        if (n_[b] == 0) return 0.0;
+        double m = mean(b);
+        double var = std::max(0.0, sum2_[b] / n_[b] - m * m);
+        return std::sqrt(var) / std::sqrt(static_cast<double>(n_[b]));
+    }
+
+private:
+    int nbins_;
+    double xmin_;
+    double xmax_;
+    double width_;
+    std::vector<size_t> n_;
+    std::vector<double> sum_;
+    std::vector<double> sum2_;
+};
+
+#endif
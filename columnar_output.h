@@ -0,0 +1,188 @@
+#ifndef COLUMNAR_OUTPUT_H
+#define COLUMNAR_OUTPUT_H
+
+#include <ROOT/TBufferMerger.hxx>
+#include <TFile.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Row schemas for the analyzer outputs. Each row type lists its columns once in
+// visit_columns(); the TTree writer, the TTree reader and the CSV export all use it.
+
+// One track-plane efficiency measurement (hit_analyzer.C)
+struct HitEffRow {
+    int trk_id = 0;
+    int plane = 0;
+    int tpc = 0;
+    float track_length = 0;
+    int valid_hits = 0;
+    int non_dead_wires = 0;
+    float efficiency = 0;
+    float avg_pitch = 0;
+};
+
+template <class Op>
+void visit_columns(HitEffRow& row, Op op) {
+    op("TrackID", row.trk_id);
+    op("Plane", row.plane);
+    op("TPC", row.tpc);
+    op("TrackLength", row.track_length);
+    op("ValidHits", row.valid_hits);
+    op("NonDeadWires", row.non_dead_wires);
+    op("Efficiency", row.efficiency);
+    op("AvgPitch", row.avg_pitch);
+}
+
+// One track-plane measurement inside a TPC region (hit_split_regions_*.C)
+struct RegionRow {
+    int trk_id = 0;
+    int plane = 0;
+    int tpc = 0;
+    float track_length = 0;
+    int valid_hits = 0;
+    float min_x = 0, max_x = 0;
+    float min_y = 0, max_y = 0;
+    float min_z = 0, max_z = 0;
+    float avg_pitch = 0;
+    float hit_eff = 0;
+    int anode_tpc0_hits = 0;
+    int cathode_hits = 0;
+    int anode_tpc1_hits = 0;
+    int other_hits = 0;
+};
+
+template <class Op>
+void visit_columns(RegionRow& row, Op op) {
+    op("TrackID", row.trk_id);
+    op("Plane", row.plane);
+    op("TPC", row.tpc);
+    op("TrackLength", row.track_length);
+    op("ValidHits", row.valid_hits);
+    op("MinX", row.min_x);
+    op("MaxX", row.max_x);
+    op("MinY", row.min_y);
+    op("MaxY", row.max_y);
+    op("MinZ", row.min_z);
+    op("MaxZ", row.max_z);
+    op("AvgPitch", row.avg_pitch);
+    op("HitEfficiency", row.hit_eff);
+    op("AnodeTPC0_Hits", row.anode_tpc0_hits);
+    op("Cathode_Hits", row.cathode_hits);
+    op("AnodeTPC1_Hits", row.anode_tpc1_hits);
+    op("Other_Hits", row.other_hits);
+}
+
+// CSV export (optional; the TTree output is what the plotters read)
+template <class Row>
+void write_csv_header(std::ostream& out) {
+    Row row;
+    bool first = true;
+    visit_columns(row, [&](const char* name, auto&) {
+        out << (first ? "" : ",") << name;
+        first = false;
+    });
+    out << "\n";
+}
+
+template <class Row>
+void write_csv_row(std::ostream& out, Row row) {
+    bool first = true;
+    visit_columns(row, [&](const char*, auto& value) {
+        if (!first) out << ",";
+        out << value;
+        first = false;
+    });
+    out << "\n";
+}
+
+// Writes rows into one or more TTrees of a single output file from many threads.
+// Each file worker fills TTrees in its own in-memory TBufferMergerFile, so filling
+// takes no lock; once a worker has buffered flush_bytes of rows they are handed to the
+// merger, which appends them to the output file in the background. The destructor
+// hands over the remaining rows, and writes the (empty) trees if no row was filled at
+// all, so the output always has every tree the readers expect.
+template <class Row>
+class ColumnarWriter {
+public:
+    ColumnarWriter(const std::string& path, const std::vector<std::string>& tree_names, unsigned n_workers,
+                   size_t flush_bytes = 32u << 20)
+        : merger_(path.c_str()), tree_names_(tree_names), workers_(n_workers),
+          flush_rows_(std::max<size_t>(1, flush_bytes / sizeof(Row))) {}
+
+    ~ColumnarWriter() {
+        bool any_open = false;
+        for (auto& w : workers_) {
+            if (!w.file) continue;
+            any_open = true;
+            if (w.pending_rows > 0) w.file->Write();
+        }
+        if (!any_open && !workers_.empty()) {
+            open(workers_[0]);
+            workers_[0].file->Write();
+        }
+    }
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    void fill(unsigned worker, size_t tree_idx, const Row& row) {
+        Worker& w = workers_[worker];
+        if (!w.file) open(w);
+        w.row = row;
+        w.trees[tree_idx]->Fill();
+        if (++w.pending_rows >= flush_rows_) {
+            w.file->Write();
+            w.pending_rows = 0;
+        }
+    }
+
+private:
+    struct Worker {
+        std::shared_ptr<ROOT::TBufferMergerFile> file;
+        std::vector<TTree*> trees; // Owned by file
+        Row row;
+        size_t pending_rows = 0;   // Filled since the last hand-over to the merger
+    };
+
+    void open(Worker& w) {
+        w.file = merger_.GetFile();
+        for (const auto& name : tree_names_) {
+            TTree* tree = new TTree(name.c_str(), name.c_str());
+            tree->SetDirectory(w.file.get());
+            visit_columns(w.row, [&](const char* column, auto& value) { tree->Branch(column, &value); });
+            w.trees.push_back(tree);
+        }
+    }
+
+    ROOT::TBufferMerger merger_; // Declared first so it outlives the worker files
+    std::vector<std::string> tree_names_;
+    std::vector<Worker> workers_;
+    const size_t flush_rows_;
+};
+
+// Read every row of tree_name in path and pass it to on_row. Columns are loaded
+// straight from the TTree baskets, without any text parsing. Returns false if the
+// file or tree cannot be opened.
+template <class Row, class F>
+bool read_rows(const std::string& path, const std::string& tree_name, F&& on_row) {
+    std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+    if (!file || file->IsZombie()) return false;
+    TTree* tree = dynamic_cast<TTree*>(file->Get(tree_name.c_str()));
+    if (!tree) return false;
+
+    Row row;
+    visit_columns(row, [&](const char* column, auto& value) { tree->SetBranchAddress(column, &value); });
+    Long64_t n_entries = tree->GetEntries();
+    for (Long64_t i = 0; i < n_entries; ++i) {
+        tree->GetEntry(i);
+        on_row(row);
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef DEAD_CHANNEL_MASK_H
+#define DEAD_CHANNEL_MASK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fnv1a.h"
+
+// Dense dead-channel mask indexed by (TPC, plane, wire).
+// Each (TPC, plane) keeps a flat bitset of dead wires plus a prefix sum of dead
+// counts, so is_dead() is a single bit test and count_live() over a wire span is
+// one subtraction. Wires, planes or TPCs outside the loaded range are live.
+class DeadChannelMask {
+public:
+    static constexpr unsigned short kNPlanes = 3;
+
+    // Load dead channels from a "Wire,Plane,TPC" CSV (as written by dead_wires.C).
+    // Returns false if the file cannot be opened; invalid lines (including values out
+    // of range, e.g. plane >= kNPlanes) are reported on log and skipped.
+    bool load(const std::string& csv_path, std::ostream& log = std::cout) {
+        std::ifstream dead_csv(csv_path);
+        if (!dead_csv.is_open()) return false;
+
+        std::string header, line;
+        std::getline(dead_csv, header); // Skip header
+        while (std::getline(dead_csv, line)) {
+            std::stringstream ss(line);
+            std::string wire_str, plane_str, tpc_str;
+            std::getline(ss, wire_str, ',');
+            std::getline(ss, plane_str, ',');
+            std::getline(ss, tpc_str, ',');
+            try {
+                add(parse_field(wire_str), parse_field(plane_str), parse_field(tpc_str));
+            } catch (...) {
+                log << "Warning: Invalid line in " << csv_path << ": " << line << std::endl;
+            }
+        }
+        dead_csv.close();
+        finalize();
+        return true;
+    }
+
+    // Mark a channel as dead. Call finalize() after the last add().
+    // Throws std::out_of_range for plane >= kNPlanes.
+    void add(unsigned short wire, unsigned short plane, unsigned short tpc) {
+        if (plane >= kNPlanes) throw std::out_of_range("plane " + std::to_string(plane) + " >= " + std::to_string(kNPlanes));
+        size_t idx = index(plane, tpc);
+        if (idx >= planes_.size()) planes_.resize(idx + 1);
+        auto& bits = planes_[idx].bits;
+        size_t word = wire / 64;
+        if (word >= bits.size()) bits.resize(word + 1, 0);
+        uint64_t mask = uint64_t(1) << (wire % 64);
+        if (!(bits[word] & mask)) {
+            bits[word] |= mask;
+            n_dead_++;
+        }
+    }
+
+    // Build the per-plane prefix sums used by count_live()
+    void finalize() {
+        for (auto& p : planes_) {
+            size_t n_wires = p.bits.size() * 64;
+            p.dead_before.assign(n_wires + 1, 0);
+            for (size_t w = 0; w < n_wires; ++w) {
+                p.dead_before[w + 1] = p.dead_before[w] + ((p.bits[w / 64] >> (w % 64)) & 1);
+            }
+        }
+    }
+
+    bool is_dead(unsigned short wire, unsigned short plane, unsigned short tpc) const {
+        if (plane >= kNPlanes) return false;
+        size_t idx = index(plane, tpc);
+        if (idx >= planes_.size()) return false;
+        const auto& bits = planes_[idx].bits;
+        size_t word = wire / 64;
+        return word < bits.size() && ((bits[word] >> (wire % 64)) & 1);
+    }
+
+    // Number of non-dead wires in [min_wire, max_wire] (inclusive)
+    int count_live(unsigned short min_wire, unsigned short max_wire, unsigned short plane, unsigned short tpc) const {
+        if (max_wire < min_wire) return 0;
+        int span = static_cast<int>(max_wire) - min_wire + 1;
+        if (plane >= kNPlanes) return span;
+        size_t idx = index(plane, tpc);
+        if (idx >= planes_.size()) return span;
+        const auto& dead_before = planes_[idx].dead_before;
+        if (dead_before.empty()) return span;
+        size_t last = dead_before.size() - 1;
+        size_t lo = std::min<size_t>(min_wire, last);
+        size_t hi = std::min<size_t>(static_cast<size_t>(max_wire) + 1, last);
+        return span - static_cast<int>(dead_before[hi] - dead_before[lo]);
+    }
+
+    size_t size() const { return n_dead_; }
+
+    // Content hash (FNV-1a over the dead wires), used to key cached results
+    uint64_t hash() const {
+        uint64_t h = kFnv1aOffset;
+        for (size_t idx = 0; idx < planes_.size(); ++idx) {
+            const auto& bits = planes_[idx].bits;
+            for (size_t word = 0; word < bits.size(); ++word) {
+                if (bits[word] == 0) continue;
+                uint64_t entry[3] = {idx, word, bits[word]};
+                h = fnv1a(entry, sizeof(entry), h);
+            }
+        }
+        return h;
+    }
+
+private:
+    struct PlaneMask {
+        std::vector<uint64_t> bits;        // bit w set if wire w is dead
+        std::vector<uint32_t> dead_before; // dead_before[w] = dead wires in [0, w)
+    };
+
+    // One CSV field as an unsigned short; throws instead of wrapping around
+    static unsigned short parse_field(const std::string& field) {
+        int value = std::stoi(field);
+        if (value < 0 || value > std::numeric_limits<unsigned short>::max()) throw std::out_of_range(field);
+        return static_cast<unsigned short>(value);
+    }
+
+    static size_t index(unsigned short plane, unsigned short tpc) {
+        return static_cast<size_t>(tpc) * kNPlanes + plane;
+    }
+
+    std::vector<PlaneMask> planes_;
+    size_t n_dead_ = 0;
+};
+
+#endif
@@ -0,0 +1,428 @@
+#ifndef FILE_PREFETCHER_H
+#define FILE_PREFETCHER_H
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "fnv1a.h"
+#include "input_stat.h"
+
+// Prefetches input files into a size-bounded local disk cache ahead of the analysis.
+// Background threads copy the next `lookahead` files (beyond the ones already handed
+// out) while the current ones are being analyzed. acquire() returns a lease on the
+// cached copy if it is ready, waits for it if it is being copied (so the file is not
+// read over the network twice), and otherwise returns the original URL so the caller
+// reads the file directly.
+//
+// One cache directory can serve every analyzer and dataset, also from concurrent
+// jobs: cached files are named after a hash of the full URL and the source's size and
+// modification time, so a copy is only reused for an unchanged input (the copy of a
+// regenerated input no longer matches and is evicted first), and the size bound
+// counts every file in the directory, including other jobs' copies in flight. Each
+// copy reserves its size before it starts. To make room, files already read (and
+// files of other file lists) are evicted first, least recently used first; files
+// still ahead of the read cursor are only evicted for a file needed sooner. Files
+// being read are pinned; a copy that only fits once they are released waits for
+// that. Leases touch the cached file, so files in use by another job are evicted last.
+//
+// The source stats (stat_input_file) and the copy function (copy_input_file, both in
+// input_file.h) are supplied by the caller, so the class itself does not depend on
+// ROOT. Files that could not be stat'ed are never cached. The copy function reports
+// how many bytes it read through ROOT, so callers can tell the copies apart from the
+// analysis in ROOT's global read counter.
+class FilePrefetcher {
+public:
+    using CopyFn = std::function<bool(const std::string& src, const std::string& dst, int64_t& root_bytes_read)>;
+
+    // Path to read one input file from; holds the cached copy in place (unevictable)
+    // until the lease is destroyed, also if the analysis of the file throws
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept { *this = std::move(other); }
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                owner_ = other.owner_;
+                idx_ = other.idx_;
+                path_ = std::move(other.path_);
+                other.owner_ = nullptr;
+            }
+            return *this;
+        }
+        ~Lease() { reset(); }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        const std::string& path() const { return path_; }
+        bool cached() const { return owner_ != nullptr; }
+
+        void reset() {
+            if (owner_) owner_->release(idx_);
+            owner_ = nullptr;
+        }
+
+    private:
+        friend class FilePrefetcher;
+        Lease(FilePrefetcher* owner, size_t idx, std::string path) : owner_(owner), idx_(idx), path_(std::move(path)) {}
+
+        FilePrefetcher* owner_ = nullptr;
+        size_t idx_ = 0;
+        std::string path_;
+    };
+
+    // stats[i] is the current size and modification time of urls[i]
+    FilePrefetcher(const std::vector<std::string>& urls, const std::vector<InputStat>& stats, const std::string& cache_dir,
+                   uint64_t max_bytes, unsigned lookahead, unsigned n_fetch_threads, CopyFn copy)
+        : urls_(urls), stats_(stats), cache_dir_(cache_dir), max_bytes_(max_bytes), lookahead_(std::max(1u, lookahead)),
+          copy_(std::move(copy)), part_suffix_(make_part_suffix()), entries_(urls.size()) {
+        std::filesystem::create_directories(cache_dir_);
+        for (size_t i = 0; i < urls_.size(); ++i) {
+            names_.push_back(cache_file_name(urls_[i], stats_[i]));
+            if (stats_[i].valid()) {
+                by_name_[names_[i]] = i;
+            } else {
+                entries_[i].state = State::Skipped; // Cannot tell a stale copy from a current one
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            index_existing_files();
+            make_room(0, 0); // The bound may have been lowered since the last run
+        }
+        for (unsigned t = 0; t < std::max(1u, n_fetch_threads); ++t) {
+            fetchers_.emplace_back([this]() { fetch_loop(); });
+        }
+    }
+
+    ~FilePrefetcher() { stop(); }
+
+    FilePrefetcher(const FilePrefetcher&) = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+    // Lease on file idx: the cached copy if it is ready or being copied (waits for the
+    // copy to finish), otherwise the URL
+    Lease acquire(size_t idx) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        n_acquired_++;
+        Entry& e = entries_[idx];
+        e.acquired = true; // Also stops a copy still waiting for room
+        cv_.notify_all();  // Window moved forward
+        if (e.state == State::Pending) e.state = State::Skipped; // Too late to prefetch
+        if (e.state == State::Fetching) {
+            n_waited_++;
+            cv_.wait(lock, [&]() { return e.state != State::Fetching; });
+        }
+        if (e.state == State::Ready) {
+            // Touching the copy marks it as in use for other jobs sharing the directory,
+            // and fails if one of them has evicted it
+            std::error_code ec;
+            std::filesystem::last_write_time(local_path(idx), std::filesystem::file_time_type::clock::now(), ec);
+            if (!ec) {
+                e.pins++;
+                n_pinned_++;
+                n_hits_++;
+                return Lease(this, idx, local_path(idx));
+            }
+            e.state = State::Skipped;
+        }
+        n_direct_++;
+        return Lease(nullptr, idx, urls_[idx]);
+    }
+
+    // Where file idx is (or would be) cached
+    std::string local_path(size_t idx) const {
+        return (std::filesystem::path(cache_dir_) / names_[idx]).string();
+    }
+
+    // Stops prefetching and waits for the copies in progress to finish
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : fetchers_) t.join();
+        fetchers_.clear();
+    }
+
+    // Bytes written into the cache by completed copies
+    uint64_t bytes_copied() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bytes_copied_;
+    }
+
+    // Bytes the copy function read through ROOT, failed copies included
+    int64_t root_bytes_read() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return root_bytes_read_;
+    }
+
+    // Cache summary for the end-of-run printout
+    void print_summary(std::ostream& out, const std::string& label) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "[" << label << "] Cache: " << n_hits_ << " files read from " << cache_dir_ << " ("
+            << n_waited_ << " after waiting for their copy), "
+            << n_direct_ << " read directly; " << n_copied_ << " copied (" << (bytes_copied_ >> 20) << " MB), "
+            << n_failed_ << " not copied, " << n_evicted_ << " evicted" << std::endl;
+    }
+
+private:
+    enum class State { Pending, Fetching, Ready, Failed, Skipped };
+
+    struct Entry {
+        State state = State::Pending;
+        int pins = 0;
+        bool acquired = false; // Handed out at least once; evictable first once unpinned
+    };
+
+    struct CachedFile {
+        std::filesystem::path path;
+        uint64_t bytes;
+        std::filesystem::file_time_type last_use;
+        size_t idx; // Entry index, or urls_.size() for files of other file lists
+    };
+
+    // Cached name: hash of the full URL (files of different datasets or directories can
+    // share a file name) and of the source's size and modification time, followed by
+    // the original name for readability
+    static std::string cache_file_name(const std::string& url, const InputStat& stat) {
+        int64_t version[2] = {stat.size, stat.mtime};
+        uint64_t h = fnv1a(version, sizeof(version), fnv1a(url));
+        char hash[20];
+        std::snprintf(hash, sizeof(hash), "%016llx_", static_cast<unsigned long long>(h));
+        return hash + std::filesystem::path(url).filename().string();
+    }
+
+    static std::string host_name() {
+        char host[256] = {};
+        gethostname(host, sizeof(host) - 1);
+        return host;
+    }
+
+    // In-flight copies are named <file>.<host>.<pid>.part, so a job can tell its own
+    // copies from other jobs' and remove the ones left behind by a job that died
+    static std::string make_part_suffix() {
+        return "." + host_name() + "." + std::to_string(getpid()) + ".part";
+    }
+
+    static bool is_stale_part(const std::filesystem::directory_entry& f) {
+        std::string name = f.path().stem().string(); // Without ".part"
+        std::string host = "." + host_name() + ".";
+        size_t pid_dot = name.rfind('.');
+        size_t host_pos = name.rfind(host);
+        if (pid_dot != std::string::npos && host_pos != std::string::npos && host_pos + host.size() == pid_dot + 1) {
+            long pid = std::strtol(name.c_str() + pid_dot + 1, nullptr, 10);
+            if (pid > 0) return kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+        }
+        // Another host's copy (or an unknown name): stale once nobody has written it for a day
+        std::error_code ec;
+        auto age = std::filesystem::file_time_type::clock::now() - f.last_write_time(ec);
+        return !ec && age > std::chrono::hours(24);
+    }
+
+    // Pick up copies left by earlier runs and drop interrupted copies. Called with mutex_ held.
+    void index_existing_files() {
+        std::error_code ec;
+        for (const auto& f : std::filesystem::directory_iterator(cache_dir_, ec)) {
+            if (!f.is_regular_file(ec)) continue;
+            if (f.path().extension() == ".part") {
+                if (is_stale_part(f)) std::filesystem::remove(f.path(), ec);
+                continue;
+            }
+            auto it = by_name_.find(f.path().filename().string());
+            if (it != by_name_.end()) entries_[it->second].state = State::Ready;
+        }
+    }
+
+    // Evict files until `bytes` more fit under max_bytes, counting everything in the
+    // directory plus the reservations of this job's copies in flight. Eviction order:
+    // files already read and files of other file lists (least recently used first),
+    // then files still ahead of the read cursor but needed after fetch_idx (furthest
+    // first). Pinned files are never evicted. Called with mutex_ held; returns false
+    // if the space cannot be freed.
+    bool make_room(uint64_t bytes, size_t fetch_idx) {
+        const size_t kNoEntry = urls_.size();
+        std::vector<CachedFile> consumed, ahead;
+        uint64_t used = reserved_bytes_;
+        std::error_code ec;
+        for (const auto& f : std::filesystem::directory_iterator(cache_dir_, ec)) {
+            if (!f.is_regular_file(ec)) continue;
+            uint64_t size = f.file_size(ec);
+            if (ec) continue;
+            std::string name = f.path().filename().string();
+            if (f.path().extension() == ".part") {
+                if (!own_parts_.count(name)) used += size; // Another job's copy in flight
+                continue;
+            }
+            used += size;
+            auto it = by_name_.find(name);
+            size_t idx = it == by_name_.end() ? kNoEntry : it->second;
+            if (idx != kNoEntry) {
+                const Entry& e = entries_[idx];
+                if (e.pins > 0) continue;
+                if (e.state == State::Ready && !e.acquired) {
+                    if (idx > fetch_idx) ahead.push_back({f.path(), size, {}, idx});
+                    continue;
+                }
+            }
+            consumed.push_back({f.path(), size, f.last_write_time(ec), idx});
+        }
+        if (used + bytes <= max_bytes_) return true;
+
+        std::sort(consumed.begin(), consumed.end(),
+                  [](const CachedFile& a, const CachedFile& b) { return a.last_use < b.last_use; });
+        std::sort(ahead.begin(), ahead.end(), [](const CachedFile& a, const CachedFile& b) { return a.idx > b.idx; });
+        consumed.insert(consumed.end(), ahead.begin(), ahead.end());
+        for (const auto& victim : consumed) {
+            std::filesystem::remove(victim.path, ec);
+            if (ec) continue;
+            used -= std::min(used, victim.bytes);
+            n_evicted_++;
+            if (victim.idx != kNoEntry && entries_[victim.idx].state == State::Ready) {
+                entries_[victim.idx].state = State::Skipped; // Already read, or will be read directly
+            }
+            if (used + bytes <= max_bytes_) return true;
+        }
+        return false;
+    }
+
+    void fetch_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [&]() {
+                return stop_ || next_fetch_ >= urls_.size() || next_fetch_ < n_acquired_ + lookahead_;
+            });
+            if (stop_ || next_fetch_ >= urls_.size()) return;
+
+            size_t idx = next_fetch_++;
+            Entry& e = entries_[idx];
+            if (e.state != State::Pending) continue;
+            e.state = State::Fetching;
+
+            std::string src = urls_[idx];
+            std::string dst = local_path(idx);
+            std::string part_name = std::filesystem::path(dst).filename().string() + part_suffix_;
+            std::string part = dst + part_suffix_;
+            uint64_t expected = static_cast<uint64_t>(stats_[idx].size);
+            lock.unlock();
+            bool found = std::filesystem::exists(dst); // Copied meanwhile by another job
+            lock.lock();
+
+            if (found) {
+                finish(e, State::Ready);
+                continue;
+            }
+            bool room = make_room(expected, idx);
+            // Files being read are only pinned until their lease ends: wait for that
+            // instead of giving up on a file that fits once they are released
+            while (!room && n_pinned_ > 0 && !stop_ && !e.acquired) {
+                cv_.wait(lock);
+                room = make_room(expected, idx);
+            }
+            if (!room) {
+                if (!e.acquired) n_failed_++;
+                finish(e, e.acquired ? State::Skipped : State::Failed);
+                continue;
+            }
+            reserved_bytes_ += expected;
+            own_parts_.insert(part_name);
+            lock.unlock();
+            int64_t root_bytes = 0;
+            bool ok = copy_(src, part, root_bytes);
+            std::error_code ec;
+            uint64_t bytes = ok ? std::filesystem::file_size(part, ec) : 0;
+            ok = ok && !ec && bytes == expected; // Not the version that was stat'ed
+            lock.lock();
+            root_bytes_read_ += root_bytes;
+
+            // The copy now counts with its real size instead of the reservation
+            reserved_bytes_ -= expected;
+            own_parts_.erase(part_name);
+            if (ok && make_room(0, idx)) {
+                std::filesystem::rename(part, dst, ec);
+                ok = !ec;
+            } else {
+                ok = false;
+            }
+            if (ok) {
+                n_copied_++;
+                bytes_copied_ += bytes;
+                finish(e, State::Ready);
+            } else {
+                std::filesystem::remove(part, ec);
+                n_failed_++;
+                finish(e, State::Failed);
+            }
+        }
+    }
+
+    // Ends a fetch; acquire() may be waiting for it. Called with mutex_ held.
+    void finish(Entry& e, State state) {
+        e.state = state;
+        cv_.notify_all();
+    }
+
+    // Called by ~Lease. The copy's modification time is its last use for eviction.
+    void release(size_t idx) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& e = entries_[idx];
+        if (e.pins > 0) {
+            e.pins--;
+            n_pinned_--;
+        }
+        std::error_code ec;
+        std::filesystem::last_write_time(local_path(idx), std::filesystem::file_time_type::clock::now(), ec);
+        cv_.notify_all(); // A fetch may be waiting for room
+    }
+
+    const std::vector<std::string> urls_;
+    const std::vector<InputStat> stats_;
+    std::vector<std::string> names_; // Cached file name of each entry
+    const std::string cache_dir_;
+    const uint64_t max_bytes_;
+    const size_t lookahead_;
+    const CopyFn copy_;
+    const std::string part_suffix_;
+    std::map<std::string, size_t> by_name_; // Cached file name -> entry index
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Entry> entries_;
+    std::vector<std::thread> fetchers_;
+    std::set<std::string> own_parts_; // This job's copies in flight (counted by reservation)
+    size_t next_fetch_ = 0;
+    size_t n_acquired_ = 0;
+    size_t n_pinned_ = 0; // Leases on cached files not yet released
+    uint64_t reserved_bytes_ = 0;
+    uint64_t bytes_copied_ = 0;
+    int64_t root_bytes_read_ = 0;
+    size_t n_hits_ = 0;
+    size_t n_waited_ = 0; // acquire() calls that waited for a copy in progress
+    size_t n_direct_ = 0;
+    size_t n_copied_ = 0;
+    size_t n_failed_ = 0;
+    size_t n_evicted_ = 0;
+    bool stop_ = false;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef FILE_SCHEDULER_H
+#define FILE_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of file workers to use when none is configured: one per core,
+// but never more than there are files
+inline unsigned default_file_workers(size_t n_files) {
+    unsigned n_cores = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(n_cores, n_files)));
+}
+
+// How to spread n_files over the cores. With at least as many files as cores, each
+// worker processes whole files single-threaded. With fewer files, a file pool would
+// leave cores idle, so files are processed one at a time with ROOT's implicit
+// multithreading inside each file instead; the per-file callback must then keep
+// per-slot state (RDataFrame ForeachSlot). A configured n_file_workers always uses
+// the file pool.
+struct FilePoolPlan {
+    unsigned n_workers = 1;
+    bool implicit_mt = false;
+};
+
+inline FilePoolPlan plan_file_pool(size_t n_files, unsigned n_file_workers) {
+    FilePoolPlan plan;
+    unsigned n_cores = std::max(1u, std::thread::hardware_concurrency());
+    if (n_file_workers > 0) {
+        plan.n_workers = n_file_workers;
+    } else if (n_files >= n_cores || n_cores == 1) {
+        plan.n_workers = default_file_workers(n_files);
+    } else {
+        plan.implicit_mt = true;
+    }
+    return plan;
+}
+
+// Run process_file(file_idx, worker) for every file index in [0, n_files) on a
+// pool of n_workers threads. Workers pull the next file index from a shared
+// counter as soon as they finish their current file, so slow files (e.g. XRootD
+// stalls) only hold up one worker. worker is in [0, n_workers) and can be used
+// to index per-worker accumulators that are merged after run_file_pool returns.
+// The first exception thrown by process_file is rethrown once all workers stop.
+inline void run_file_pool(size_t n_files, unsigned n_workers,
+                          const std::function<void(size_t, unsigned)>& process_file) {
+    n_workers = std::max(1u, n_workers);
+    std::atomic<size_t> next_file{0};
+    std::exception_ptr first_error;
+    std::mutex error_mutex;
+
+    auto worker_loop = [&](unsigned worker) {
+        for (size_t file_idx = next_file++; file_idx < n_files; file_idx = next_file++) {
+            try {
+                process_file(file_idx, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) first_error = std::current_exception();
+                next_file = n_files; // Stop handing out files
+                return;
+            }
+        }
+    };
+
+    if (n_workers == 1) {
+        worker_loop(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned w = 0; w < n_workers; ++w) workers.emplace_back(worker_loop, w);
+        for (auto& t : workers) t.join();
+    }
+    if (first_error) std::rethrow_exception(first_error);
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef FNV1A_H
+#define FNV1A_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 64-bit FNV-1a hash, used for cache file names and configuration keys
+constexpr uint64_t kFnv1aOffset = 14695981039346656037ull;
+
+inline uint64_t fnv1a(const void* data, size_t n, uint64_t h = kFnv1aOffset) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+inline uint64_t fnv1a(const std::string& s, uint64_t h = kFnv1aOffset) {
+    return fnv1a(s.data(), s.size(), h);
+}
+
+#endif
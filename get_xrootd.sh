@@ -1,12 +1,16 @@
 #!/bin/bash
 
-while read -r fname; do
-    if [ -n "$fname" ]; then
-        furl=$(samweb get-file-access-url --schema root "$fname" 2>/dev/null)
-        if [ $? -eq 0 ] && [ -n "$furl" ]; then
-            echo "$furl"
-        else
-            echo "Error: Failed to get XRootD URL for $fname" >&2
-        fi
+# Number of samweb lookups to run at once
+N_JOBS=${N_JOBS:-8}
+
+resolve_url() {
+    furl=$(samweb get-file-access-url --schema root "$1" 2>/dev/null)
+    if [ $? -eq 0 ] && [ -n "$furl" ]; then
+        echo "$furl"
+    else
+        echo "Error: Failed to get XRootD URL for $1" >&2
     fi
-done < filelist_data.txt
\ No newline at end of file
+}
+export -f resolve_url
+
+grep -v '^[[:space:]]*$' filelist_data.txt | xargs -P "$N_JOBS" -I{} bash -c 'resolve_url "$1"' _ {}
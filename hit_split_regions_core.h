@@ -0,0 +1,505 @@
+#ifndef HIT_SPLIT_REGIONS_CORE_H
+#define HIT_SPLIT_REGIONS_CORE_H
+
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/RVec.hxx>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+#include "dead_channel_mask.h"
+#include "file_scheduler.h"
+#include "file_prefetcher.h"
+#include "input_file.h"
+#include "columnar_output.h"
+#include "result_cache.h"
+#include "region_lookup.h"
+#include "stage_timer.h"
+
+// Region-split hit efficiency shared by hit_split_regions_data.C and
+// hit_split_regions_mc.C. The macros only fill in a SplitRegionsConfig.
+
+struct SplitRegionsConfig {
+    std::string filelist;            // Input file list
+    std::string tag;                 // "data" or "mc": names the outputs and cache directories
+    std::string label;               // "Data" or "MC" for printouts
+    std::string output_dir = "split_regions"; // Output ROOT file, CSV exports and timing summary
+    bool write_timing = true;        // Per-stage timing and throughput summary in <output_dir>/split_regions_<tag>_timing.json
+
+    unsigned n_file_workers = 0;     // Files processed in parallel (0 = one per core)
+    std::string cache_dir = "";      // Local prefetch cache for input files, can be shared by all analyzers ("" = read inputs directly)
+    double cache_max_gb = 50.0;      // Size limit of the whole cache directory
+    unsigned prefetch_lookahead = 0; // Files copied ahead of the ones being analyzed (0 = two per file worker)
+    unsigned n_fetch_threads = 4;    // Files copied into the cache in parallel
+    bool write_csv = false;          // Also export each region as <output_dir>/<region>_hits_<tag>.csv
+    std::string result_cache_dir = "split_regions/cache"; // Per-file results for resuming and extending runs ("" = off)
+
+    // Selection cuts; together with the regions and dead channels they key the result cache
+    float min_track_length = 50.0f;  // Track length cut (cm)
+    size_t min_region_hits = 10;     // Minimum valid hits of a track in a region
+    size_t min_unique_wires = 25;    // Minimum unique wires of a track in a region
+    int max_wire_gap = 11;           // Largest allowed gap between consecutive wires
+    int analysis_version = 1;        // Bump when the selection code changes
+
+    std::vector<SplitRegion> regions = default_split_regions();
+};
+
+// Stages timed per file worker; reported in the timing summary. file_open is opening
+// each input file and its tree, event_loop the RDataFrame setup and event loop over
+// it (reading the baskets included).
+enum SplitRegionsStage { kSplitStagePrefetchWait, kSplitStageFileOpen, kSplitStageEventLoop, kSplitStageOutput, kSplitStageCachedResults, kNSplitStages };
+const char* const kSplitStageNames[kNSplitStages] = {"prefetch_wait", "file_open", "event_loop", "output", "cached_results"};
+
+// One cached output row together with the region tree it belongs to
+struct RegionRecord {
+    int region = 0;
+    RegionRow row;
+};
+
+inline void run_split_regions(const SplitRegionsConfig& config) {
+    const std::vector<SplitRegion>& regions = config.regions;
+    const std::string output_name = config.output_dir + "/split_regions_" + config.tag + ".root";
+    auto wall_start = StageTimer::Clock::now();
+    Long64_t bytes_read_start = TFile::GetFileBytesRead();
+
+    // Enable ROOT thread safety ONCE at the start; each file worker runs its own RDataFrame,
+    // or with fewer files than cores one RDataFrame at a time uses implicit MT (see plan_file_pool)
+    ROOT::EnableThreadSafety();
+
+    // Create output directory
+    std::filesystem::create_directories(config.output_dir);
+
+    // Load input files
+    std::vector<std::string> filenames;
+    std::ifstream fileList(config.filelist);
+    std::string line;
+    while (std::getline(fileList, line)) {
+        if (!line.empty()) filenames.push_back(line);
+    }
+    fileList.close();
+
+    // Statistics accumulators
+    std::atomic<size_t> total_samples{0};
+    size_t total_events = 0;
+
+    // Create separate CSV files for each region (optional export)
+    std::vector<std::unique_ptr<std::ofstream>> csv_files;
+    std::vector<std::string> region_names;
+    for (const auto& region : regions) {
+        region_names.push_back(region.name);
+        if (!config.write_csv) continue;
+        std::string filename = config.output_dir + "/" + region.name + "_hits_" + config.tag + ".csv";
+        auto csv_file = std::make_unique<std::ofstream>(filename);
+        write_csv_header<RegionRow>(*csv_file);
+        csv_files.push_back(std::move(csv_file));
+    }
+
+    // Load dead channels from CSV
+    DeadChannelMask dead_channels;
+    if (dead_channels.load("dead_channels.csv")) {
+        std::cout << "Loaded " << dead_channels.size() << " dead channels" << std::endl;
+    } else {
+        std::cout << "Warning: Could not open dead_channels.csv, proceeding without dead channel filtering" << std::endl;
+    }
+
+    // Cached per-file results are only reused if the cuts, regions and dead channels match
+    std::ostringstream cut_summary;
+    cut_summary << "hit_split_regions v" << config.analysis_version << " length>" << config.min_track_length
+                << " hits>=" << config.min_region_hits << " wires>=" << config.min_unique_wires
+                << " gap<=" << config.max_wire_gap;
+    for (const auto& region : regions) {
+        cut_summary << " " << region.name << ":" << region.tpc_id << "," << region.y_min << "," << region.y_max
+                    << "," << region.z_min << "," << region.z_max;
+    }
+    uint64_t result_key = fnv1a(cut_summary.str(), dead_channels.hash());
+
+    RegionLookup region_lookup(regions);
+
+    // Helper function to check for holes > 10 consecutive wires
+    auto has_large_holes = [&](const std::vector<unsigned short>& sorted_wires) {
+        if (sorted_wires.size() < 2) return false;
+        for (size_t i = 1; i < sorted_wires.size(); ++i) {
+            if (sorted_wires[i] - sorted_wires[i-1] > config.max_wire_gap) return true;
+        }
+        return false;
+    };
+
+    // Running summary of one track's hits in one region. The wire list keeps its
+    // capacity between tracks, so after the first few tracks nothing is allocated.
+    struct RegionAccumulator {
+        int n_hits = 0;
+        float min_x, max_x, min_y, max_y, min_z, max_z;
+        float sum_pitch = 0.0f;
+        int valid_pitches = 0;
+        int x_hits[kNXRegions] = {0, 0, 0, 0};
+        std::vector<unsigned short> wires;
+
+        void reset() {
+            n_hits = 0;
+            min_x = min_y = min_z = std::numeric_limits<float>::max();
+            max_x = max_y = max_z = std::numeric_limits<float>::lowest();
+            sum_pitch = 0.0f;
+            valid_pitches = 0;
+            std::fill(std::begin(x_hits), std::end(x_hits), 0);
+            wires.clear();
+        }
+    };
+
+    // Scratch and rows of one RDataFrame processing slot; with implicit MT a file is
+    // split over several slots, whose rows are merged once the file is done
+    struct SlotBuffers {
+        std::vector<RegionAccumulator> accumulators; // One per region, reused for every track
+        std::vector<RegionRecord> records;           // Rows of this slot's part of the file
+        size_t n_tracks = 0;
+        size_t n_hits = 0;
+    };
+
+    // Per-worker slots, region CSV buffers and event counts, flushed after each file.
+    // Sized for the most workers the pool below can use.
+    struct WorkerBuffers {
+        unsigned worker = 0;
+        std::vector<SlotBuffers> slots;         // Kept between files so the scratch is reused
+        std::vector<RegionRecord> file_records; // Rows of the file being processed
+        std::vector<std::ostringstream> region_csv;
+        std::vector<size_t> region_entries;
+        size_t total_events = 0;
+        StageTimer stages{kNSplitStages};
+        size_t n_tracks = 0;
+        size_t n_hits = 0;
+    };
+    unsigned max_workers = config.n_file_workers > 0 ? config.n_file_workers : default_file_workers(filenames.size());
+    std::vector<WorkerBuffers> worker_buffers(max_workers);
+    for (unsigned w = 0; w < max_workers; ++w) {
+        worker_buffers[w].worker = w;
+        worker_buffers[w].region_csv.resize(regions.size());
+        worker_buffers[w].region_entries.resize(regions.size(), 0);
+    }
+
+    // One TTree per region in a single output file; each worker fills its own buffer
+    auto writer = std::make_unique<ColumnarWriter<RegionRow>>(output_name, region_names, max_workers);
+    std::mutex csv_mutex;
+    std::mutex cout_mutex;
+
+    // Add one file's rows to the worker's counts, the output file and the region CSVs
+    auto merge_file_records = [&](WorkerBuffers& buffers, const std::vector<RegionRecord>& records) {
+        for (const auto& record : records) {
+            writer->fill(buffers.worker, record.region, record.row);
+            if (config.write_csv) write_csv_row(buffers.region_csv[record.region], record.row);
+            buffers.region_entries[record.region]++;
+            buffers.total_events++;
+        }
+        if (config.write_csv) {
+            std::lock_guard<std::mutex> lock(csv_mutex);
+            for (size_t i = 0; i < regions.size(); ++i) {
+                *csv_files[i] << buffers.region_csv[i].str();
+                buffers.region_csv[i].str("");
+            }
+        }
+    };
+
+    // Process hits for each region
+    auto process_hits = [&](SlotBuffers& buffers, int trk_id, float track_length,
+                           const ROOT::RVec<unsigned short>& wires,
+                           const ROOT::RVec<float>& pitches,
+                           const ROOT::RVec<unsigned short>& tpcs,
+                           const ROOT::RVec<float>& x_coords,
+                           const ROOT::RVec<float>& y_coords,
+                           const ROOT::RVec<float>& z_coords,
+                           const ROOT::RVec<bool>& ontraj,
+                           int plane) {
+
+        if (wires.empty()) return;
+
+        // Accumulate every valid hit into its region in a single pass
+        auto& accumulators = buffers.accumulators;
+        for (auto& acc : accumulators) acc.reset();
+
+        size_t n = std::min({wires.size(), x_coords.size(), y_coords.size(), z_coords.size(),
+                             tpcs.size(), ontraj.size(), pitches.size()});
+        for (size_t i = 0; i < n; ++i) {
+            // Skip invalid hits
+            if (!ontraj[i] || pitches[i] == -1.0f) continue;
+            if (std::isnan(x_coords[i]) || std::isnan(y_coords[i]) || std::isnan(z_coords[i])) continue;
+
+            // Skip dead channels
+            if (dead_channels.is_dead(wires[i], plane, tpcs[i])) continue;
+
+            int region_idx = region_lookup.find(y_coords[i], z_coords[i], tpcs[i]);
+            if (region_idx < 0) continue;
+
+            RegionAccumulator& acc = accumulators[region_idx];
+            acc.n_hits++;
+            acc.min_x = std::min(acc.min_x, x_coords[i]);
+            acc.max_x = std::max(acc.max_x, x_coords[i]);
+            acc.min_y = std::min(acc.min_y, y_coords[i]);
+            acc.max_y = std::max(acc.max_y, y_coords[i]);
+            acc.min_z = std::min(acc.min_z, z_coords[i]);
+            acc.max_z = std::max(acc.max_z, z_coords[i]);
+            if (pitches[i] > 0) {
+                acc.sum_pitch += pitches[i];
+                acc.valid_pitches++;
+            }
+            acc.x_hits[classify_x_region(x_coords[i])]++;
+            acc.wires.push_back(wires[i]);
+        }
+
+        // Process each region
+        for (size_t region_idx = 0; region_idx < regions.size(); ++region_idx) {
+            RegionAccumulator& acc = accumulators[region_idx];
+            if (static_cast<size_t>(acc.n_hits) < config.min_region_hits) continue; // Skip regions with too few hits
+
+            // Unique wires, ascending, then check for large holes
+            auto& sorted_wires = acc.wires;
+            std::sort(sorted_wires.begin(), sorted_wires.end());
+            sorted_wires.erase(std::unique(sorted_wires.begin(), sorted_wires.end()), sorted_wires.end());
+            if (sorted_wires.size() < config.min_unique_wires) continue;
+            if (has_large_holes(sorted_wires)) continue;
+
+            float avg_pitch = acc.valid_pitches > 0 ? acc.sum_pitch / acc.valid_pitches : 0.0f;
+
+            // Compute hit efficiency
+            float hit_eff = 0.0f;
+            unsigned short tpc = static_cast<unsigned short>(regions[region_idx].tpc_id);
+            int num_live = dead_channels.count_live(sorted_wires.front(), sorted_wires.back(), plane, tpc);
+            if (num_live > 0) {
+                hit_eff = static_cast<float>(sorted_wires.size()) / static_cast<float>(num_live);
+            }
+
+            // Keep the row for the region's tree (including the X-coordinate flags)
+            RegionRow row;
+            row.trk_id = trk_id;
+            row.plane = plane;
+            row.tpc = regions[region_idx].tpc_id;
+            row.track_length = track_length;
+            row.valid_hits = acc.n_hits;
+            row.min_x = acc.min_x;
+            row.max_x = acc.max_x;
+            row.min_y = acc.min_y;
+            row.max_y = acc.max_y;
+            row.min_z = acc.min_z;
+            row.max_z = acc.max_z;
+            row.avg_pitch = avg_pitch;
+            row.hit_eff = hit_eff;
+            row.anode_tpc0_hits = acc.x_hits[kAnodeTPC0];
+            row.cathode_hits = acc.x_hits[kCathode];
+            row.anode_tpc1_hits = acc.x_hits[kAnodeTPC1];
+            row.other_hits = acc.x_hits[kOtherX];
+            buffers.records.push_back({static_cast<int>(region_idx), row});
+        }
+    };
+
+    // Reuse cached results of files already processed with the same cuts; only the
+    // remaining files (new ones, or ones interrupted or stale) are analyzed below
+    std::unique_ptr<ResultCache> result_cache;
+    if (!config.result_cache_dir.empty()) {
+        result_cache = std::make_unique<ResultCache>(config.result_cache_dir + "/" + config.tag, result_key);
+    }
+
+    // Cached results and prefetched copies are only valid for an unchanged input, so stat every input first
+    // (in parallel: for XRootD inputs each stat is a round trip to the server)
+    std::vector<std::string> todo;
+    std::vector<InputStat> todo_stats;
+    size_t n_cached = 0;
+    auto cached_start = StageTimer::Clock::now();
+    std::vector<InputStat> input_stats(filenames.size());
+    if (result_cache || !config.cache_dir.empty()) {
+        run_file_pool(filenames.size(), default_file_workers(filenames.size()), [&](size_t i, unsigned) {
+            input_stats[i] = stat_input_file(filenames[i]);
+        });
+    }
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        size_t n_records = 0;
+        std::vector<RegionRecord>& cached = worker_buffers[0].file_records;
+        if (result_cache && result_cache->load(filenames[i], input_stats[i], n_records, cached) && n_records == cached.size()) {
+            merge_file_records(worker_buffers[0], cached); // The pool has not started, so worker 0's buffers are free
+            n_cached++;
+        } else {
+            todo.push_back(filenames[i]);
+            todo_stats.push_back(input_stats[i]);
+        }
+    }
+    worker_buffers[0].stages.add(kSplitStageCachedResults, cached_start, StageTimer::Clock::now());
+    if (result_cache) {
+        std::cout << config.label << " files from " << config.result_cache_dir << ": " << n_cached
+                  << ", to process: " << todo.size() << std::endl;
+    }
+
+    // A file pool when there are enough files to keep every core busy, otherwise one
+    // file at a time with implicit MT
+    FilePoolPlan plan = plan_file_pool(todo.size(), config.n_file_workers);
+
+    // Optionally stream upcoming input files into a local cache while earlier ones are analyzed
+    std::unique_ptr<FilePrefetcher> prefetcher;
+    if (!config.cache_dir.empty() && !todo.empty()) {
+        unsigned lookahead = config.prefetch_lookahead > 0 ? config.prefetch_lookahead : 2 * plan.n_workers;
+        prefetcher = std::make_unique<FilePrefetcher>(todo, todo_stats, config.cache_dir, static_cast<uint64_t>(config.cache_max_gb * (1ull << 30)),
+                                                      lookahead, config.n_fetch_threads, copy_input_file);
+    }
+
+    // Process each remaining ROOT file individually; workers pull file indices from a shared queue
+    if (plan.implicit_mt) ROOT::EnableImplicitMT();
+    run_file_pool(todo.size(), plan.n_workers, [&](size_t file_idx, unsigned worker) {
+        WorkerBuffers& buffers = worker_buffers[worker];
+        buffers.file_records.clear();
+
+        FilePrefetcher::Lease input;
+        {
+            ScopedStage wait_stage(buffers.stages, kSplitStagePrefetchWait);
+            if (prefetcher) input = prefetcher->acquire(file_idx);
+        }
+        std::string input_file = prefetcher ? input.path() : todo[file_idx];
+
+        InputTree input_tree;
+        {
+            ScopedStage open_stage(buffers.stages, kSplitStageFileOpen);
+            input_tree = open_input_tree(input_file, "caloskim/TrackCaloSkim");
+        }
+
+        auto loop_start = StageTimer::Clock::now();
+        ROOT::RDataFrame rdf_file(*input_tree.tree);
+        if (buffers.slots.size() < rdf_file.GetNSlots()) buffers.slots.resize(rdf_file.GetNSlots());
+        for (auto& slot : buffers.slots) {
+            slot.accumulators.resize(regions.size());
+            slot.records.clear();
+            slot.n_tracks = 0;
+            slot.n_hits = 0;
+        }
+
+        // Filter tracks with length > min_track_length
+        auto rdf_filtered = rdf_file.Filter([&](float length) { return length > config.min_track_length; }, {"trk.length"});
+
+        // Process data for each plane
+        rdf_filtered.ForeachSlot([&](unsigned slot, int trk_id, float track_length,
+                               // Plane 0 data
+                               const ROOT::RVec<unsigned short>& wires0, const ROOT::RVec<float>& pitches0, const ROOT::RVec<unsigned short>& tpcs0,
+                               const ROOT::RVec<float>& x0, const ROOT::RVec<float>& y0, const ROOT::RVec<float>& z0, const ROOT::RVec<bool>& ontraj0,
+                               // Plane 1 data
+                               const ROOT::RVec<unsigned short>& wires1, const ROOT::RVec<float>& pitches1, const ROOT::RVec<unsigned short>& tpcs1,
+                               const ROOT::RVec<float>& x1, const ROOT::RVec<float>& y1, const ROOT::RVec<float>& z1, const ROOT::RVec<bool>& ontraj1,
+                               // Plane 2 data
+                               const ROOT::RVec<unsigned short>& wires2, const ROOT::RVec<float>& pitches2, const ROOT::RVec<unsigned short>& tpcs2,
+                               const ROOT::RVec<float>& x2, const ROOT::RVec<float>& y2, const ROOT::RVec<float>& z2, const ROOT::RVec<bool>& ontraj2) {
+
+            SlotBuffers& slot_buffers = buffers.slots[slot];
+            process_hits(slot_buffers, trk_id, track_length, wires0, pitches0, tpcs0, x0, y0, z0, ontraj0, 0);
+            process_hits(slot_buffers, trk_id, track_length, wires1, pitches1, tpcs1, x1, y1, z1, ontraj1, 1);
+            process_hits(slot_buffers, trk_id, track_length, wires2, pitches2, tpcs2, x2, y2, z2, ontraj2, 2);
+            slot_buffers.n_tracks++;
+            slot_buffers.n_hits += wires0.size() + wires1.size() + wires2.size();
+
+        }, {"trk.id", "trk.length",
+            // Plane 0
+            "trk.hits0.h.wire", "trk.hits0.pitch", "trk.hits0.h.tpc",
+            "trk.hits0.h.sp.x", "trk.hits0.h.sp.y", "trk.hits0.h.sp.z", "trk.hits0.ontraj",
+            // Plane 1
+            "trk.hits1.h.wire", "trk.hits1.pitch", "trk.hits1.h.tpc",
+            "trk.hits1.h.sp.x", "trk.hits1.h.sp.y", "trk.hits1.h.sp.z", "trk.hits1.ontraj",
+            // Plane 2
+            "trk.hits2.h.wire", "trk.hits2.pitch", "trk.hits2.h.tpc",
+            "trk.hits2.h.sp.x", "trk.hits2.h.sp.y", "trk.hits2.h.sp.z", "trk.hits2.ontraj"});
+
+        buffers.stages.add(kSplitStageEventLoop, loop_start, StageTimer::Clock::now());
+        input.reset(); // The cached copy may be evicted from here on
+        for (const auto& slot : buffers.slots) {
+            buffers.file_records.insert(buffers.file_records.end(), slot.records.begin(), slot.records.end());
+            buffers.n_tracks += slot.n_tracks;
+            buffers.n_hits += slot.n_hits;
+        }
+
+        // Checkpoint the file, then hand its rows to the output merger and the region CSVs
+        {
+            ScopedStage output_stage(buffers.stages, kSplitStageOutput);
+            if (result_cache && !result_cache->store(todo[file_idx], todo_stats[file_idx], buffers.file_records.size(), buffers.file_records)) {
+                std::lock_guard<std::mutex> lock(cout_mutex);
+                std::cout << "Warning: Could not cache results for " << todo[file_idx] << std::endl;
+            }
+            merge_file_records(buffers, buffers.file_records);
+        }
+
+        // Update sample count and print checkpoint
+        size_t n_done = ++total_samples;
+        if (n_done % 10 == 0) {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << "Processed " << n_done << " samples" << std::endl;
+        }
+    });
+    if (plan.implicit_mt) ROOT::DisableImplicitMT();
+
+    total_samples += n_cached;
+    {
+        ScopedStage output_stage(worker_buffers[0].stages, kSplitStageOutput);
+        writer.reset(); // Finish writing the output file
+    }
+
+    std::vector<size_t> region_entries(regions.size(), 0);
+    for (const auto& buffers : worker_buffers) {
+        total_events += buffers.total_events;
+        for (size_t i = 0; i < regions.size(); ++i) region_entries[i] += buffers.region_entries[i];
+    }
+
+    // Close all CSV files and print region statistics
+    std::cout << "\n=== Processing Statistics ===\n";
+    std::cout << "Total samples processed: " << total_samples << "\n";
+    std::cout << "Total events recorded: " << total_events << "\n";
+    if (prefetcher) prefetcher->print_summary(std::cout, config.label);
+
+    std::cout << "\n=== Region Statistics ===\n";
+    for (size_t i = 0; i < regions.size(); ++i) {
+        if (config.write_csv) csv_files[i]->close();
+
+        std::cout << regions[i].name << " (TPC " << regions[i].tpc_id << ", y:["
+                  << regions[i].y_min << "," << regions[i].y_max << "], z:["
+                  << regions[i].z_min << "," << regions[i].z_max << "]): "
+                  << region_entries[i] << " entries\n";
+    }
+
+    std::cout << "\nOutput saved in " << output_name
+              << (config.write_csv ? " (CSV files also saved in " + config.output_dir + "/)" : std::string()) << "\n";
+
+    // Wait for copies still in flight, so the prefetcher's reads are complete before
+    // they are taken out of ROOT's global read counter
+    if (prefetcher) prefetcher->stop();
+
+    TimingSummary summary;
+    summary.dataset = config.label;
+    summary.n_files = filenames.size();
+    summary.n_files_cached = n_cached;
+    summary.n_workers = plan.n_workers;
+    summary.implicit_mt = plan.implicit_mt;
+    summary.wall_seconds = std::chrono::duration<double>(StageTimer::Clock::now() - wall_start).count();
+    summary.stages = StageTimer(kNSplitStages);
+    summary.stage_names = kSplitStageNames;
+    for (const auto& buffers : worker_buffers) {
+        summary.stages.merge(buffers.stages);
+        summary.n_tracks += buffers.n_tracks;
+        summary.n_hits += buffers.n_hits;
+    }
+    summary.analysis_bytes = TFile::GetFileBytesRead() - bytes_read_start;
+    if (prefetcher) {
+        summary.analysis_bytes -= prefetcher->root_bytes_read();
+        summary.prefetch_bytes = static_cast<int64_t>(prefetcher->bytes_copied());
+    }
+    summary.peak_rss = peak_rss_kb();
+    summary.print(std::cout);
+
+    if (config.write_timing) {
+        std::string timing_json = config.output_dir + "/split_regions_" + config.tag + "_timing.json";
+        if (write_timing_json(timing_json, {summary})) {
+            std::cout << "Timing summary saved in " << timing_json << std::endl;
+        } else {
+            std::cout << "Warning: Could not write " << timing_json << std::endl;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef INPUT_FILE_H
+#define INPUT_FILE_H
+
+#include <TFile.h>
+#include <TSystem.h>
+#include <TTree.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "input_stat.h"
+
+// Helpers for reading the analyzers' input files, local or over XRootD
+
+// Stat an input file: plain paths through std::filesystem, root:// (or any other URL)
+// through gSystem, which hands the request to the XRootD plugin (one round trip)
+inline InputStat stat_input_file(const std::string& path) {
+    InputStat stat;
+    if (path.find("://") == std::string::npos) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec) return stat;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) return stat;
+        stat.size = static_cast<int64_t>(size);
+        stat.mtime = std::chrono::duration_cast<std::chrono::seconds>(mtime.time_since_epoch()).count();
+        return stat;
+    }
+    FileStat_t info;
+    if (gSystem->GetPathInfo(path.c_str(), info) != 0) return stat;
+    stat.size = info.fSize;
+    stat.mtime = info.fMtime;
+    return stat;
+}
+
+// Copy one input file into the prefetch cache. root:// (or any other URL) sources go
+// through TFile::Cp; plain paths are copied directly, so a local directory can stand
+// in for the remote store when testing offline. The copy is only accepted if ROOT can
+// open it. root_bytes_read is what the copy added to TFile::GetFileBytesRead(): the
+// whole file for TFile::Cp, plus what the check read.
+inline bool copy_input_file(const std::string& src, const std::string& dst, int64_t& root_bytes_read) {
+    root_bytes_read = 0;
+    bool ok = false;
+    if (src.find("://") == std::string::npos) {
+        std::error_code ec;
+        ok = std::filesystem::copy_file(src, dst, std::filesystem::copy_options::overwrite_existing, ec);
+    } else {
+        ok = TFile::Cp(src.c_str(), dst.c_str(), kFALSE);
+        std::error_code ec;
+        auto size = std::filesystem::file_size(dst, ec);
+        if (!ec) root_bytes_read += static_cast<int64_t>(size);
+    }
+    if (!ok) return false;
+    std::unique_ptr<TFile> check(TFile::Open(dst.c_str(), "READ"));
+    if (check) root_bytes_read += check->GetBytesRead();
+    return check && !check->IsZombie();
+}
+
+// An input file opened for the event loop; the tree is owned by the file
+struct InputTree {
+    std::unique_ptr<TFile> file;
+    TTree* tree = nullptr;
+};
+
+// Open an input file and find its tree, so the analyzers can time the open (the XRootD
+// round trips and the header reads) apart from the event loop. Throws if either fails.
+inline InputTree open_input_tree(const std::string& path, const std::string& tree_name) {
+    InputTree input;
+    input.file.reset(TFile::Open(path.c_str(), "READ"));
+    if (!input.file || input.file->IsZombie()) throw std::runtime_error("Could not open " + path);
+    input.tree = input.file->Get<TTree>(tree_name.c_str());
+    if (!input.tree) throw std::runtime_error("No tree " + tree_name + " in " + path);
+    return input;
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef INPUT_STAT_H
+#define INPUT_STAT_H
+
+#include <cstdint>
+
+// Size and modification time of an input file, used to notice inputs regenerated
+// under the same name. size < 0 means the file could not be stat'ed.
+struct InputStat {
+    int64_t size = -1;
+    int64_t mtime = 0; // Seconds since the epoch of the file's clock
+
+    bool valid() const { return size >= 0; }
+    bool operator==(const InputStat& other) const { return size == other.size && mtime == other.mtime; }
+};
+
+#endif
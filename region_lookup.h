@@ -0,0 +1,107 @@
+#ifndef REGION_LOOKUP_H
+#define REGION_LOOKUP_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Detector regions of the region-split analysis and the lookup that assigns hits to
+// them. Kept free of ROOT so test_region_lookup.cc can check it on its own.
+
+// One (TPC, y, z) box; hits are assigned to the first box containing them
+struct SplitRegion {
+    std::string name;
+    float y_min, y_max, z_min, z_max;
+    int tpc_id;
+};
+
+// 8 regions (4 per TPC)
+inline std::vector<SplitRegion> default_split_regions() {
+    return {
+        {"TPC0_00", -203.732f, 0.0f, -5.68434e-14f,244.7f, 0},
+        {"TPC0_01", 0.0f, 203.732f, -5.68434e-14f,244.7f, 0},
+        {"TPC0_10", -203.732f, 0.0f,264.7f, 500.1f, 0},
+        {"TPC0_11", 0.0f, 203.732f,264.7f, 500.1f, 0},
+        {"TPC1_00", -203.732f, 0.0f, -5.68434e-14f,244.7f, 1},
+        {"TPC1_01", 0.0f, 203.732f, -5.68434e-14f,244.7f, 1},
+        {"TPC1_10", -203.732f, 0.0f,264.7f, 500.1f, 1},
+        {"TPC1_11", 0.0f, 203.732f,264.7f, 500.1f, 1}
+    };
+}
+
+// X-coordinate classes counted per region row
+enum XRegion { kAnodeTPC0 = 0, kCathode, kAnodeTPC1, kOtherX, kNXRegions };
+
+inline int classify_x_region(float x) {
+    if (x >= -202.2f && x <= -152.2f) return kAnodeTPC0;
+    if (x >= -50.0f && x <= 50.0f) return kCathode;
+    if (x >= 152.2f && x <= 202.2f) return kAnodeTPC1;
+    return kOtherX;
+}
+
+// Maps (TPC, y, z) to a region index with a precomputed grid instead of testing every
+// region. The y and z edges of all regions split each TPC into cells; every cell lies
+// entirely inside or outside each region, so the cell's region is looked up once here.
+class RegionLookup {
+public:
+    explicit RegionLookup(const std::vector<SplitRegion>& regions) {
+        int max_tpc = -1;
+        for (const auto& r : regions) max_tpc = std::max(max_tpc, r.tpc_id);
+        tpcs_.resize(max_tpc + 1);
+        for (int tpc = 0; tpc <= max_tpc; ++tpc) {
+            Grid& g = tpcs_[tpc];
+            for (const auto& r : regions) {
+                if (r.tpc_id != tpc) continue;
+                g.y_edges.insert(g.y_edges.end(), {r.y_min, r.y_max});
+                g.z_edges.insert(g.z_edges.end(), {r.z_min, r.z_max});
+            }
+            for (auto* edges : {&g.y_edges, &g.z_edges}) {
+                std::sort(edges->begin(), edges->end());
+                edges->erase(std::unique(edges->begin(), edges->end()), edges->end());
+            }
+            size_t ny = g.y_edges.empty() ? 0 : g.y_edges.size() - 1;
+            size_t nz = g.z_edges.empty() ? 0 : g.z_edges.size() - 1;
+            g.cells.assign(ny * nz, -1);
+            for (size_t iy = 0; iy < ny; ++iy) {
+                for (size_t iz = 0; iz < nz; ++iz) {
+                    for (size_t i = 0; i < regions.size(); ++i) {
+                        const auto& r = regions[i];
+                        if (r.tpc_id == tpc &&
+                            g.y_edges[iy] >= r.y_min && g.y_edges[iy + 1] <= r.y_max &&
+                            g.z_edges[iz] >= r.z_min && g.z_edges[iz + 1] <= r.z_max) {
+                            g.cells[iy * nz + iz] = static_cast<int>(i);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Region index, or -1 if (y, z) is in no region of this TPC
+    int find(float y, float z, unsigned short tpc) const {
+        if (tpc >= tpcs_.size()) return -1;
+        const Grid& g = tpcs_[tpc];
+        int iy = cell_index(g.y_edges, y);
+        int iz = cell_index(g.z_edges, z);
+        if (iy < 0 || iz < 0) return -1;
+        return g.cells[iy * (g.z_edges.size() - 1) + iz];
+    }
+
+private:
+    struct Grid {
+        std::vector<float> y_edges, z_edges;
+        std::vector<int> cells; // Region index per (y cell, z cell), -1 if none
+    };
+
+    // i such that edges[i] <= v < edges[i + 1], or -1
+    static int cell_index(const std::vector<float>& edges, float v) {
+        auto it = std::upper_bound(edges.begin(), edges.end(), v);
+        if (it == edges.begin() || it == edges.end()) return -1;
+        return static_cast<int>(it - edges.begin()) - 1;
+    }
+
+    std::vector<Grid> tpcs_;
+};
+
+#endif
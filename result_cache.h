@@ -0,0 +1,112 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "fnv1a.h"
+#include "input_file.h"
+
+// Per-input-file result cache for checkpointing and incremental reprocessing.
+// Each input file's partial result (a POD summary plus a vector of POD records) is
+// stored in its own file under dir, named after a hash of the input file name. The
+// entry also records a key, which callers derive from the cuts, dead-channel mask and
+// analysis version, and the input's size and modification time. An entry whose key
+// or input stat does not match is stale and is recomputed, as is any entry for an
+// input that cannot be stat'ed. A restarted or extended job only processes files
+// without a valid entry and merges the cached partials for the rest.
+class ResultCache {
+public:
+    ResultCache(const std::string& dir, uint64_t key) : dir_(dir), key_(key) {
+        std::filesystem::create_directories(dir_);
+    }
+
+    template <class Summary, class Record>
+    bool load(const std::string& input, const InputStat& stat, Summary& summary, std::vector<Record>& records) const {
+        check_pod<Summary, Record>();
+        if (!stat.valid()) return false;
+        std::ifstream in(path_for(input), std::ios::binary);
+        if (!in.is_open()) return false;
+
+        Header header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (header.magic != kMagic || header.key != key_ ||
+            header.summary_size != sizeof(Summary) || header.record_size != sizeof(Record) ||
+            header.input_size != stat.size || header.input_mtime != stat.mtime) return false;
+
+        std::string name(header.name_length, '\0');
+        if (!in.read(&name[0], name.size()) || name != input) return false;
+        if (!in.read(reinterpret_cast<char*>(&summary), sizeof(Summary))) return false;
+        records.resize(header.n_records);
+        if (!records.empty() && !in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record))) return false;
+        return true;
+    }
+
+    // Write the entry to a temporary file and rename it into place, so an
+    // interrupted job never leaves a truncated entry behind. stat is the input's stat
+    // taken before it was read; nothing is stored if it is not valid.
+    template <class Summary, class Record>
+    bool store(const std::string& input, const InputStat& stat, const Summary& summary, const std::vector<Record>& records) const {
+        check_pod<Summary, Record>();
+        if (!stat.valid()) return false;
+        std::string path = path_for(input);
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            Header header;
+            header.key = key_;
+            header.input_size = stat.size;
+            header.input_mtime = stat.mtime;
+            header.summary_size = sizeof(Summary);
+            header.record_size = sizeof(Record);
+            header.name_length = input.size();
+            header.n_records = records.size();
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(input.data(), input.size());
+            out.write(reinterpret_cast<const char*>(&summary), sizeof(Summary));
+            if (!records.empty()) out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+            if (!out) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        return !ec;
+    }
+
+private:
+    static constexpr uint64_t kMagic = 0x32464548434c5248ull; // File format tag, bump on layout changes
+
+    struct Header {
+        uint64_t magic = kMagic;
+        uint64_t key = 0;
+        int64_t input_size = 0;
+        int64_t input_mtime = 0;
+        uint64_t summary_size = 0;
+        uint64_t record_size = 0;
+        uint64_t name_length = 0;
+        uint64_t n_records = 0;
+    };
+
+    template <class Summary, class Record>
+    static void check_pod() {
+        static_assert(std::is_trivially_copyable<Summary>::value, "cached summary must be trivially copyable");
+        static_assert(std::is_trivially_copyable<Record>::value, "cached records must be trivially copyable");
+    }
+
+    std::string path_for(const std::string& input) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(fnv1a(input)));
+        return (std::filesystem::path(dir_) / name).string();
+    }
+
+    std::string dir_;
+    uint64_t key_;
+};
+
+#endif
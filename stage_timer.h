@@ -0,0 +1,119 @@
+#ifndef STAGE_TIMER_H
+#define STAGE_TIMER_H
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Accumulated wall time per processing stage. Each file worker owns one StageTimer
+// and merge() adds them up after the pool finishes, so the totals are thread-seconds
+// summed over workers (compare them with each other, or divide by the worker count).
+class StageTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StageTimer(size_t n_stages = 0) : seconds_(n_stages, 0.0) {}
+
+    void add(size_t stage, double seconds) { seconds_[stage] += seconds; }
+
+    void add(size_t stage, Clock::time_point start, Clock::time_point end) {
+        seconds_[stage] += std::chrono::duration<double>(end - start).count();
+    }
+
+    void merge(const StageTimer& other) {
+        for (size_t i = 0; i < seconds_.size() && i < other.seconds_.size(); ++i) seconds_[i] += other.seconds_[i];
+    }
+
+    double seconds(size_t stage) const { return seconds_[stage]; }
+    size_t size() const { return seconds_.size(); }
+
+private:
+    std::vector<double> seconds_;
+};
+
+// Times the enclosing scope into one stage of a StageTimer
+class ScopedStage {
+public:
+    ScopedStage(StageTimer& timer, size_t stage) : timer_(timer), stage_(stage), start_(StageTimer::Clock::now()) {}
+    ~ScopedStage() { timer_.add(stage_, start_, StageTimer::Clock::now()); }
+
+    ScopedStage(const ScopedStage&) = delete;
+    ScopedStage& operator=(const ScopedStage&) = delete;
+
+private:
+    StageTimer& timer_;
+    size_t stage_;
+    StageTimer::Clock::time_point start_;
+};
+
+// Peak resident set size of this process so far, in kB (Linux ru_maxrss units)
+inline long peak_rss_kb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+// Throughput summary of one analyzer pass over one dataset: printed at the end of the
+// pass and written to the machine-readable timing file. Stage times are summed over
+// workers, rates use the wall time.
+struct TimingSummary {
+    std::string dataset;
+    size_t n_files = 0;
+    size_t n_files_cached = 0;   // Taken from the result cache instead of being read
+    unsigned n_workers = 1;
+    bool implicit_mt = false;
+    double wall_seconds = 0.0;
+    uint64_t n_tracks = 0;
+    uint64_t n_hits = 0;
+    int64_t analysis_bytes = 0;  // Read through ROOT by the analysis itself
+    int64_t prefetch_bytes = 0;  // Copied into the prefetch cache in the background
+    long peak_rss = 0;           // kB
+    StageTimer stages;
+    const char* const* stage_names = nullptr; // One per stage of `stages`
+
+    double tracks_per_second() const { return wall_seconds > 0 ? n_tracks / wall_seconds : 0.0; }
+    double hits_per_second() const { return wall_seconds > 0 ? n_hits / wall_seconds : 0.0; }
+
+    std::string json() const {
+        std::ostringstream out;
+        out << "{\"dataset\": \"" << dataset << "\", \"files\": " << n_files
+            << ", \"files_from_cache\": " << n_files_cached << ", \"workers\": " << n_workers
+            << ", \"implicit_mt\": " << (implicit_mt ? "true" : "false")
+            << ", \"wall_s\": " << wall_seconds << ", \"tracks\": " << n_tracks << ", \"hits\": " << n_hits
+            << ", \"tracks_per_s\": " << tracks_per_second() << ", \"hits_per_s\": " << hits_per_second()
+            << ", \"analysis_bytes\": " << analysis_bytes << ", \"prefetch_bytes\": " << prefetch_bytes
+            << ", \"peak_rss_kb\": " << peak_rss << ", \"stages_s\": {";
+        for (size_t i = 0; i < stages.size(); ++i) {
+            out << (i ? ", " : "") << "\"" << stage_names[i] << "\": " << stages.seconds(i);
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    void print(std::ostream& out) const {
+        out << "\n=== Timing for " << dataset << " ===" << std::endl;
+        out << "Wall time: " << wall_seconds << " s, " << tracks_per_second() << " tracks/s, "
+            << hits_per_second() << " hits/s, " << (analysis_bytes >> 20) << " MB read by the analysis, "
+            << (prefetch_bytes >> 20) << " MB prefetched, peak RSS " << (peak_rss >> 10) << " MB\n";
+        out << "Worker time per stage (s):";
+        for (size_t i = 0; i < stages.size(); ++i) out << " " << stage_names[i] << " = " << stages.seconds(i);
+        out << std::endl;
+    }
+};
+
+// Writes {"datasets": [...]} with one object per summary
+inline bool write_timing_json(const std::string& path, const std::vector<TimingSummary>& summaries) {
+    std::ofstream out(path);
+    out << "{\"datasets\": [";
+    for (size_t i = 0; i < summaries.size(); ++i) out << (i ? ",\n  " : "\n  ") << summaries[i].json();
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+#endif
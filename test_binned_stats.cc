@@ -0,0 +1,139 @@
+// Checks the streaming plot accumulators against the per-bin loop hit_plotter.C used
+// before them (collect the efficiencies of each pitch bin, then mean and standard
+// error), on random input split over several merged accumulators. No ROOT needed.
+//   g++ -std=c++17 -O2 -I. test_binned_stats.cc -o test_binned_stats && ./test_binned_stats
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "binned_stats.h"
+
+static int n_failures = 0;
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond "\n"; \
+            n_failures++;                                                               \
+        }                                                                               \
+    } while (0)
+
+// Same binning as the "Mean Hit Efficiency vs Pitch" plot
+const int kNBins = 30;
+const float kXMin = 0.3f;
+const float kXMax = 2.5f;
+
+struct BinResult {
+    size_t n = 0;
+    float mean = 0;
+    float err = 0;
+};
+
+// The old plotter loop, in float as it was written
+static BinResult reference_bin(const std::vector<float>& pitches, const std::vector<float>& effs, int b) {
+    float bin_width = (kXMax - kXMin) / kNBins;
+    float x_low = kXMin + b * bin_width;
+    float x_high = x_low + bin_width;
+    std::vector<float> eff_bin;
+    for (size_t i = 0; i < pitches.size(); ++i) {
+        if (pitches[i] >= x_low && pitches[i] < x_high) eff_bin.push_back(effs[i]);
+    }
+    BinResult result;
+    result.n = eff_bin.size();
+    if (eff_bin.empty()) return result;
+    float sum = std::accumulate(eff_bin.begin(), eff_bin.end(), 0.0);
+    result.mean = sum / eff_bin.size();
+    float err = 0.0;
+    for (auto v : eff_bin) err += (v - result.mean) * (v - result.mean);
+    result.err = std::sqrt(err / eff_bin.size()) / std::sqrt(eff_bin.size());
+    return result;
+}
+
+static void test_matches_reference_loop() {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> pitch(0.1f, 2.8f); // Also outside the binned range
+    std::normal_distribution<float> eff(0.97f, 0.015f);
+    std::uniform_int_distribution<int> part(0, 3);
+
+    // Pitches within float rounding of a bin edge can land in either neighbouring
+    // bin depending on float vs double edges; keep them out of the comparison
+    float bin_width = (kXMax - kXMin) / kNBins;
+    auto near_edge = [&](float x) {
+        float pos = (x - kXMin) / bin_width;
+        return std::fabs(pos - std::round(pos)) < 1e-4f;
+    };
+
+    std::vector<float> pitches, effs;
+    std::vector<BinnedStats> parts(4, BinnedStats(kNBins, kXMin, kXMax));
+    RunningStats eff_stats;
+    std::vector<RunningStats> eff_parts(4);
+    for (int i = 0; i < 200000; ++i) {
+        float x = pitch(rng);
+        float y = std::min(1.0f, eff(rng));
+        if (near_edge(x)) continue;
+        pitches.push_back(x);
+        effs.push_back(y);
+        int p = part(rng);
+        parts[p].fill(x, y);
+        eff_parts[p].fill(y);
+        eff_stats.fill(y);
+    }
+
+    BinnedStats merged(kNBins, kXMin, kXMax);
+    for (const auto& p : parts) merged.merge(p);
+    RunningStats eff_merged;
+    for (const auto& p : eff_parts) eff_merged.merge(p);
+
+    for (int b = 0; b < kNBins; ++b) {
+        BinResult ref = reference_bin(pitches, effs, b);
+        CHECK(merged.count(b) == ref.n);
+        CHECK(std::fabs(merged.mean(b) - ref.mean) < 1e-5);
+        CHECK(std::fabs(merged.mean_error(b) - ref.err) < 1e-3 * ref.err + 1e-9);
+        CHECK(std::fabs(merged.center(b) - (kXMin + (b + 0.5) * bin_width)) < 1e-6);
+    }
+
+    double sum = std::accumulate(effs.begin(), effs.end(), 0.0);
+    CHECK(eff_merged.n == effs.size());
+    CHECK(std::fabs(eff_merged.mean() - sum / effs.size()) < 1e-9);
+    CHECK(eff_merged.min == eff_stats.min);
+    CHECK(eff_merged.max == eff_stats.max);
+}
+
+static void test_edge_cases() {
+    BinnedStats stats(kNBins, kXMin, kXMax);
+    stats.fill(kXMin - 0.01, 1.0);
+    stats.fill(kXMax + 0.01, 1.0);
+    stats.fill(std::numeric_limits<double>::quiet_NaN(), 1.0);
+    stats.fill(std::numeric_limits<double>::infinity(), 1.0);
+    stats.fill(-std::numeric_limits<double>::infinity(), 1.0);
+    stats.fill(1e12, 1.0);
+    stats.fill(-1e12, 1.0);
+    stats.fill(std::numeric_limits<double>::max(), 1.0);
+    for (int b = 0; b < kNBins; ++b) {
+        CHECK(stats.count(b) == 0);
+        CHECK(stats.mean(b) == 0.0);
+        CHECK(stats.mean_error(b) == 0.0);
+    }
+    stats.fill(kXMin, 0.5);
+    CHECK(stats.count(0) == 1);
+    CHECK(stats.mean_error(0) == 0.0);
+
+    RunningStats empty;
+    CHECK(empty.mean() == 0.0);
+    CHECK(empty.min_or_zero() == 0.0f);
+    CHECK(empty.max_or_zero() == 0.0f);
+}
+
+int main() {
+    test_matches_reference_loop();
+    test_edge_cases();
+    if (n_failures > 0) {
+        std::cerr << n_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All BinnedStats tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,373 @@
+// Offline test of FilePrefetcher with a fake copy function (no ROOT, no network):
+// eviction order, the size bound, reuse of the cache across runs, byte counts, foreign
+// files in a shared directory, leases released by exceptions, acquire() waiting for a
+// copy in progress, stale copies of regenerated inputs, failed copies, and a plain
+// local directory as the source.
+//   g++ -std=c++17 -O2 -pthread -I. test_file_prefetcher.cc -o test_file_prefetcher && ./test_file_prefetcher
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "file_prefetcher.h"
+
+namespace fs = std::filesystem;
+
+static int n_failures = 0;
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond "\n"; \
+            n_failures++;                                                               \
+        }                                                                               \
+    } while (0)
+
+const uint64_t kFileBytes = 4096;
+
+// Stands in for copy_input_file: every "remote" file is kFileBytes long
+struct FakeRemote {
+    std::atomic<int> n_started{0};
+    std::atomic<int> n_copies{0};
+    std::atomic<bool> fail{false}; // Copies fail without writing anything while true
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open = true; // Copies block while false
+
+    FilePrefetcher::CopyFn copy_fn() {
+        return [this](const std::string&, const std::string& dst, int64_t& root_bytes_read) {
+            n_started++;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return open; });
+            }
+            if (fail) return false;
+            std::ofstream out(dst, std::ios::binary);
+            out << std::string(kFileBytes, 'x');
+            n_copies++;
+            root_bytes_read = kFileBytes;
+            return static_cast<bool>(out);
+        };
+    }
+
+    void set_open(bool value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = value;
+        }
+        cv.notify_all();
+    }
+};
+
+static std::vector<std::string> make_urls(const std::string& dataset, size_t n) {
+    std::vector<std::string> urls;
+    for (size_t i = 0; i < n; ++i) urls.push_back("root://fake.server//" + dataset + "/file_" + std::to_string(i) + ".root");
+    return urls;
+}
+
+// Stats of the fake remote files; bump mtime to "regenerate" them
+static std::vector<InputStat> make_stats(size_t n, int64_t mtime = 1) {
+    return std::vector<InputStat>(n, InputStat{static_cast<int64_t>(kFileBytes), mtime});
+}
+
+static uint64_t dir_bytes(const fs::path& dir) {
+    uint64_t bytes = 0;
+    for (const auto& f : fs::directory_iterator(dir)) {
+        if (f.is_regular_file()) bytes += f.file_size();
+    }
+    return bytes;
+}
+
+// Polls until cond holds, checking the size bound on every poll
+template <class Cond>
+static bool wait_for(const fs::path& dir, uint64_t max_bytes, Cond cond) {
+    for (int i = 0; i < 2000; ++i) {
+        CHECK(dir_bytes(dir) <= max_bytes);
+        if (cond()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+static fs::path fresh_dir(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() / ("file_prefetcher_test_" + std::to_string(getpid())) / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+// A file read out of order is evicted before unread files ahead of the cursor
+static void test_eviction_prefers_consumed() {
+    fs::path dir = fresh_dir("eviction");
+    FakeRemote remote;
+    auto urls = make_urls("data", 10);
+    uint64_t max_bytes = 3 * kFileBytes;
+    FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), max_bytes, 3, 1, remote.copy_fn());
+    auto cached = [&](size_t i) { return fs::exists(prefetcher.local_path(i)); };
+
+    CHECK(wait_for(dir, max_bytes, [&]() { return cached(0) && cached(1) && cached(2); }));
+    {
+        FilePrefetcher::Lease lease = prefetcher.acquire(2);
+        CHECK(lease.cached());
+        CHECK(lease.path() == prefetcher.local_path(2));
+    }
+    // The window moved by one file: file 3 needs room, and file 2 is the one already read
+    CHECK(wait_for(dir, max_bytes, [&]() { return cached(3); }));
+    CHECK(cached(0));
+    CHECK(cached(1));
+    CHECK(!cached(2));
+}
+
+// Reading a whole list never exceeds the bound, and a second run over the same list
+// with room for all files reads everything from the cache without copying again
+static void test_size_bound_and_reuse() {
+    fs::path dir = fresh_dir("reuse");
+    FakeRemote remote;
+    auto urls = make_urls("mc", 12);
+
+    uint64_t small = 4 * kFileBytes;
+    {
+        FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), small, 3, 2, remote.copy_fn());
+        for (size_t i = 0; i < urls.size(); ++i) {
+            wait_for(dir, small, [&]() { return fs::exists(prefetcher.local_path(i)); });
+            FilePrefetcher::Lease lease = prefetcher.acquire(i);
+            CHECK(dir_bytes(dir) <= small);
+        }
+    }
+    CHECK(dir_bytes(dir) <= small);
+
+    uint64_t large = urls.size() * kFileBytes;
+    {
+        int copies_before = remote.n_copies;
+        FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), large, 12, 2, remote.copy_fn());
+        wait_for(dir, large, [&]() {
+            for (size_t i = 0; i < urls.size(); ++i) {
+                if (!fs::exists(prefetcher.local_path(i))) return false;
+            }
+            return true;
+        });
+        // Only this prefetcher's own copies count
+        prefetcher.stop();
+        uint64_t copied = static_cast<uint64_t>(remote.n_copies - copies_before) * kFileBytes;
+        CHECK(prefetcher.bytes_copied() == copied);
+        CHECK(prefetcher.root_bytes_read() == static_cast<int64_t>(copied));
+    }
+    int copies_before = remote.n_copies;
+    {
+        FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), large, 12, 2, remote.copy_fn());
+        for (size_t i = 0; i < urls.size(); ++i) CHECK(prefetcher.acquire(i).cached());
+    }
+    CHECK(remote.n_copies == copies_before);
+}
+
+// Files of other file lists count towards the bound and are evicted first; the same
+// file name under different URLs gets different cache entries
+static void test_shared_directory() {
+    fs::path dir = fresh_dir("shared");
+    FakeRemote remote;
+    fs::path foreign = dir / "0123456789abcdef_other.root";
+    {
+        std::ofstream out(foreign, std::ios::binary);
+        out << std::string(kFileBytes, 'y');
+    }
+    fs::last_write_time(foreign, fs::file_time_type::clock::now() - std::chrono::hours(1));
+
+    auto data_urls = make_urls("data", 2);
+    auto mc_urls = make_urls("mc", 2);
+    uint64_t max_bytes = 2 * kFileBytes;
+    FilePrefetcher data(data_urls, make_stats(data_urls.size()), dir.string(), max_bytes, 2, 1, remote.copy_fn());
+    CHECK(wait_for(dir, max_bytes, [&]() {
+        return fs::exists(data.local_path(0)) && fs::exists(data.local_path(1));
+    }));
+    CHECK(!fs::exists(foreign));
+
+    FilePrefetcher mc(mc_urls, make_stats(mc_urls.size()), dir.string(), max_bytes, 2, 1, remote.copy_fn());
+    CHECK(mc.local_path(0) != data.local_path(0));
+}
+
+// A lease dropped by an exception unpins the file, so it can be evicted later
+static void test_lease_released_on_exception() {
+    fs::path dir = fresh_dir("exception");
+    FakeRemote remote;
+    auto urls = make_urls("data", 2);
+    uint64_t max_bytes = kFileBytes;
+    FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), max_bytes, 1, 1, remote.copy_fn());
+
+    CHECK(wait_for(dir, max_bytes, [&]() { return fs::exists(prefetcher.local_path(0)); }));
+    try {
+        FilePrefetcher::Lease lease = prefetcher.acquire(0);
+        CHECK(lease.cached());
+        throw std::runtime_error("analysis failed");
+    } catch (const std::runtime_error&) {
+    }
+    // File 1 only fits if file 0 was unpinned
+    CHECK(wait_for(dir, max_bytes, [&]() { return fs::exists(prefetcher.local_path(1)); }));
+    CHECK(!fs::exists(prefetcher.local_path(0)));
+}
+
+// acquire() waits for a copy in progress instead of reading the file a second time,
+// and hands out the URL for a file whose copy has not started
+static void test_acquire_waits_for_copy() {
+    fs::path dir = fresh_dir("wait");
+    FakeRemote remote;
+    remote.set_open(false);
+    auto urls = make_urls("data", 2);
+    FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), 4 * kFileBytes, 2, 1, remote.copy_fn());
+    CHECK(wait_for(dir, 4 * kFileBytes, [&]() { return remote.n_started == 1; }));
+
+    // One fetch thread, busy with file 0: file 1 is read directly
+    FilePrefetcher::Lease direct = prefetcher.acquire(1);
+    CHECK(!direct.cached());
+    CHECK(direct.path() == urls[1]);
+
+    std::atomic<bool> acquired{false};
+    FilePrefetcher::Lease lease;
+    std::thread reader([&]() {
+        lease = prefetcher.acquire(0);
+        acquired = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!acquired);
+    remote.set_open(true);
+    reader.join();
+    CHECK(lease.cached());
+    CHECK(lease.path() == prefetcher.local_path(0));
+    CHECK(remote.n_copies == 1);
+}
+
+// A regenerated input (new size or mtime) is copied again instead of served from the
+// old copy, and the old copy is evicted first
+static void test_stale_copy_not_reused() {
+    fs::path dir = fresh_dir("stale");
+    FakeRemote remote;
+    auto urls = make_urls("data", 3);
+    uint64_t max_bytes = urls.size() * kFileBytes;
+    std::vector<std::string> old_paths;
+    {
+        FilePrefetcher prefetcher(urls, make_stats(urls.size(), 1), dir.string(), max_bytes, 3, 1, remote.copy_fn());
+        for (size_t i = 0; i < urls.size(); ++i) {
+            CHECK(wait_for(dir, max_bytes, [&]() { return fs::exists(prefetcher.local_path(i)); }));
+            CHECK(prefetcher.acquire(i).cached());
+            old_paths.push_back(prefetcher.local_path(i));
+        }
+    }
+    int copies_before = remote.n_copies;
+    FilePrefetcher prefetcher(urls, make_stats(urls.size(), 2), dir.string(), max_bytes, 3, 1, remote.copy_fn());
+    for (size_t i = 0; i < urls.size(); ++i) {
+        CHECK(prefetcher.local_path(i) != old_paths[i]);
+        CHECK(wait_for(dir, max_bytes, [&]() { return fs::exists(prefetcher.local_path(i)); }));
+        FilePrefetcher::Lease lease = prefetcher.acquire(i);
+        CHECK(lease.cached());
+        CHECK(lease.path() == prefetcher.local_path(i));
+    }
+    CHECK(remote.n_copies - copies_before == static_cast<int>(urls.size()));
+    for (const auto& path : old_paths) CHECK(!fs::exists(path));
+    CHECK(dir_bytes(dir) <= max_bytes);
+}
+
+// A failed copy leaves nothing behind and the file is read from its URL
+static void test_failed_copy_falls_back() {
+    fs::path dir = fresh_dir("failed");
+    FakeRemote remote;
+    remote.fail = true;
+    auto urls = make_urls("data", 2);
+    FilePrefetcher prefetcher(urls, make_stats(urls.size()), dir.string(), 4 * kFileBytes, 2, 1, remote.copy_fn());
+    CHECK(wait_for(dir, 4 * kFileBytes, [&]() { return remote.n_started == 2; }));
+    for (size_t i = 0; i < urls.size(); ++i) {
+        FilePrefetcher::Lease lease = prefetcher.acquire(i);
+        CHECK(!lease.cached());
+        CHECK(lease.path() == urls[i]);
+    }
+    prefetcher.stop();
+    CHECK(prefetcher.bytes_copied() == 0);
+    CHECK(dir_bytes(dir) == 0);
+}
+
+// Plain local paths as the source, copied with std::filesystem like copy_input_file
+// does for them; a file that cannot be stat'ed is never cached
+static void test_local_directory_source() {
+    fs::path src_dir = fresh_dir("local_src");
+    fs::path dir = fresh_dir("local_cache");
+    auto stat_file = [](const fs::path& path) {
+        InputStat stat;
+        std::error_code ec;
+        auto size = fs::file_size(path, ec);
+        if (ec) return stat;
+        stat.size = static_cast<int64_t>(size);
+        stat.mtime = std::chrono::duration_cast<std::chrono::seconds>(fs::last_write_time(path).time_since_epoch()).count();
+        return stat;
+    };
+    auto write_file = [](const fs::path& path, const std::string& content) {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    };
+    auto read_file = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    FilePrefetcher::CopyFn copy = [](const std::string& src, const std::string& dst, int64_t& root_bytes_read) {
+        root_bytes_read = 0;
+        std::error_code ec;
+        return fs::copy_file(src, dst, fs::copy_options::overwrite_existing, ec);
+    };
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 3; ++i) {
+        paths.push_back((src_dir / ("file_" + std::to_string(i) + ".root")).string());
+        write_file(paths.back(), std::string(100 + i, 'a' + i));
+    }
+    paths.push_back((src_dir / "missing.root").string());
+    std::vector<InputStat> stats;
+    for (const auto& path : paths) stats.push_back(stat_file(path));
+    {
+        FilePrefetcher prefetcher(paths, stats, dir.string(), 1 << 20, 4, 2, copy);
+        for (size_t i = 0; i < 3; ++i) {
+            CHECK(wait_for(dir, 1 << 20, [&]() { return fs::exists(prefetcher.local_path(i)); }));
+            FilePrefetcher::Lease lease = prefetcher.acquire(i);
+            CHECK(lease.cached());
+            CHECK(read_file(lease.path()) == read_file(paths[i]));
+        }
+        FilePrefetcher::Lease missing = prefetcher.acquire(3);
+        CHECK(!missing.cached());
+        CHECK(missing.path() == paths[3]);
+    }
+
+    // Regenerate one source: its new content is copied, the others come from the cache
+    write_file(paths[1], "regenerated");
+    stats[1] = stat_file(paths[1]);
+    FilePrefetcher prefetcher(paths, stats, dir.string(), 1 << 20, 4, 2, copy);
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(wait_for(dir, 1 << 20, [&]() { return fs::exists(prefetcher.local_path(i)); }));
+        FilePrefetcher::Lease lease = prefetcher.acquire(i);
+        CHECK(lease.cached());
+        CHECK(read_file(lease.path()) == read_file(paths[i]));
+    }
+}
+
+int main() {
+    test_eviction_prefers_consumed();
+    test_size_bound_and_reuse();
+    test_shared_directory();
+    test_lease_released_on_exception();
+    test_acquire_waits_for_copy();
+    test_stale_copy_not_reused();
+    test_failed_copy_falls_back();
+    test_local_directory_source();
+    fs::remove_all(fs::temp_directory_path() / ("file_prefetcher_test_" + std::to_string(getpid())));
+
+    if (n_failures > 0) {
+        std::cerr << n_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All FilePrefetcher tests passed" << std::endl;
+    return 0;
+}
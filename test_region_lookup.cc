@@ -0,0 +1,97 @@
+// Randomized comparison of RegionLookup against the linear scan over the regions that
+// hit_split_regions used before it (first region containing the hit, half-open
+// y/z ranges), for the default regions and for random overlapping region sets,
+// including points exactly on region edges. No ROOT needed.
+//   g++ -std=c++17 -O2 -I. test_region_lookup.cc -o test_region_lookup && ./test_region_lookup
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "region_lookup.h"
+
+static int n_failures = 0;
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond "\n"; \
+            n_failures++;                                                               \
+        }                                                                               \
+    } while (0)
+
+static int linear_scan(const std::vector<SplitRegion>& regions, float y, float z, unsigned short tpc) {
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& r = regions[i];
+        if (r.tpc_id == tpc && y >= r.y_min && y < r.y_max && z >= r.z_min && z < r.z_max) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Compares n random points per region set; a fraction sits exactly on region edges
+static size_t count_mismatches(const std::vector<SplitRegion>& regions, std::mt19937& rng, int n,
+                               float lo, float hi, unsigned short n_tpcs) {
+    std::vector<float> y_edges, z_edges;
+    for (const auto& r : regions) {
+        y_edges.insert(y_edges.end(), {r.y_min, r.y_max});
+        z_edges.insert(z_edges.end(), {r.z_min, r.z_max});
+    }
+    std::uniform_real_distribution<float> coord(lo, hi);
+    std::uniform_int_distribution<int> tpc_dist(0, n_tpcs); // One TPC beyond the regions
+    std::uniform_int_distribution<size_t> edge(0, y_edges.size() - 1);
+    std::uniform_int_distribution<int> kind(0, 9);
+
+    RegionLookup lookup(regions);
+    size_t mismatches = 0;
+    for (int i = 0; i < n; ++i) {
+        float y = kind(rng) < 2 ? y_edges[edge(rng)] : coord(rng);
+        float z = kind(rng) < 2 ? z_edges[edge(rng)] : coord(rng);
+        unsigned short tpc = static_cast<unsigned short>(tpc_dist(rng));
+        if (lookup.find(y, z, tpc) != linear_scan(regions, y, z, tpc)) mismatches++;
+    }
+    return mismatches;
+}
+
+static void test_default_regions() {
+    std::mt19937 rng(2);
+    CHECK(count_mismatches(default_split_regions(), rng, 2000000, -250.0f, 520.0f, 2) == 0);
+}
+
+// Overlapping boxes (the first listed wins), gaps, and TPCs without any region
+static void test_random_regions() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::uniform_int_distribution<int> n_regions(1, 12);
+    std::uniform_int_distribution<int> tpc(0, 3);
+    for (int set = 0; set < 200; ++set) {
+        std::vector<SplitRegion> regions;
+        int n = n_regions(rng);
+        for (int i = 0; i < n; ++i) {
+            float y0 = coord(rng), y1 = coord(rng), z0 = coord(rng), z1 = coord(rng);
+            regions.push_back({"R" + std::to_string(i), std::min(y0, y1), std::max(y0, y1),
+                               std::min(z0, z1), std::max(z0, z1), tpc(rng)});
+        }
+        CHECK(count_mismatches(regions, rng, 20000, -120.0f, 120.0f, 4) == 0);
+    }
+}
+
+static void test_classify_x_region() {
+    CHECK(classify_x_region(-202.2f) == kAnodeTPC0);
+    CHECK(classify_x_region(-152.2f) == kAnodeTPC0);
+    CHECK(classify_x_region(-100.0f) == kOtherX);
+    CHECK(classify_x_region(0.0f) == kCathode);
+    CHECK(classify_x_region(50.0f) == kCathode);
+    CHECK(classify_x_region(202.2f) == kAnodeTPC1);
+    CHECK(classify_x_region(300.0f) == kOtherX);
+}
+
+int main() {
+    test_default_regions();
+    test_random_regions();
+    test_classify_x_region();
+    if (n_failures > 0) {
+        std::cerr << n_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All RegionLookup tests passed" << std::endl;
+    return 0;
+}